@@ -63,6 +63,18 @@
 #define CARGO_MAX_OPT_MUTEX_GROUP 4
 #endif
 
+#ifndef CARGO_RESPONSE_MAX_DEPTH
+#define CARGO_RESPONSE_MAX_DEPTH 32
+#endif
+
+#ifndef CARGO_STREAM_LOOKAHEAD
+#define CARGO_STREAM_LOOKAHEAD 16
+#endif
+
+#ifndef CARGO_SUGGESTION_DIST
+#define CARGO_SUGGESTION_DIST 1
+#endif
+
 //
 // Colors.
 //
@@ -123,6 +135,8 @@ const char *cargo_get_version();
 //
 
 typedef struct cargo_s *cargo_t;
+typedef struct cargo_spec_s *cargo_spec_t;
+typedef cargo_t cargo_state_t;
 
 typedef enum cargo_type_e
 {
@@ -155,7 +169,10 @@ typedef enum cargo_flags_e
     CARGO_DEFAULT_LITERALS              = (1 << 10),
     CARGO_SKIP_CHECK_REQUIRED           = (1 << 11),
     CARGO_SKIP_CHECK_MUTEX              = (1 << 12),
-    CARGO_SKIP_CHECK_UNKNOWN            = (1 << 13)
+    CARGO_SKIP_CHECK_UNKNOWN            = (1 << 13),
+    CARGO_ABBREV_OPTS                   = (1 << 14),
+    CARGO_SHRINK_TO_FIT                 = (1 << 15),
+    CARGO_RESPONSE_FILES                = (1 << 16)
 } cargo_flags_t;
 
 typedef enum cargo_format_e
@@ -182,7 +199,8 @@ typedef enum cargo_option_flags_e
     CARGO_OPT_HIDE                      = (1 << 5),
     CARGO_OPT_HIDE_SHORT                = (1 << 6),
     CARGO_OPT_STOP_HARD                 = (1 << 7),
-    CARGO_OPT_DEFAULT_LITERAL           = (1 << 8)
+    CARGO_OPT_DEFAULT_LITERAL           = (1 << 8),
+    CARGO_OPT_BORROW                    = (1 << 9)
 } cargo_option_flags_t;
 
 typedef enum cargo_mutex_group_flags_e
@@ -203,6 +221,8 @@ typedef enum cargo_group_flags_e
 
 typedef enum cargo_parse_result_e
 {
+    CARGO_PARSE_BAD_COMMANDLINE         = -10,
+    CARGO_PARSE_AMBIGUOUS_OPT           = -9,
     CARGO_PARSE_CALLBACK_ERR            = -8,
     CARGO_PARSE_OPT_ALREADY_PARSED      = -7,
     CARGO_PARSE_MUTEX_CONFLICT_ORDER    = -6,
@@ -239,6 +259,48 @@ typedef enum cargo_validate_choices_flags_e
     CARGO_VALIDATE_CHOICES_SET_EPSILON      = (1 << 1)
 } cargo_validate_choices_flags_t;
 
+// A name that an enum option accepts, and the value it stands for.
+typedef struct cargo_enum_s
+{
+    const char *name;
+    int value;
+} cargo_enum_t;
+
+//
+// Option table.
+//
+
+// Special values for nargs, same as "+", "*" and "?" in the format.
+#define CARGO_NARGS_ONE_OR_MORE     -1
+#define CARGO_NARGS_ZERO_OR_MORE    -2
+#define CARGO_NARGS_ZERO_OR_ONE     -3
+
+// Describes an option the same way as the arguments to cargo_add_option,
+// but without a format string (see cargo_add_options_table).
+typedef struct cargo_option_decl_s
+{
+    const char *name;               // "--alpha", or "alpha" if positional.
+    const char *aliases;            // Space separated "-a --alf", or NULL.
+    const char *description;
+    const char *metavar;
+    cargo_type_t type;
+    int nargs;                      // Like "#" or CARGO_NARGS_* for arrays.
+    int array;                      // Parse into an array "[i]".
+    int fixed;                      // Preallocated target (".").
+    size_t max_count;               // Size of a fixed array.
+    size_t lenstr;                  // Max string length ("s#").
+    void *target;
+    size_t *target_count;
+    const char *zero_or_one_default;    // CARGO_NARGS_ZERO_OR_ONE ("?").
+    int bool_store;                 // Value to store for bools ("b=").
+    int bool_count;                 // Count occurrences ("b!").
+    cargo_option_flags_t flags;
+    const char *group;
+    const char *mutex_group;
+    struct cargo_validation_s *validation;
+    cargo_validation_flags_t validation_flags;
+} cargo_option_decl_t;
+
 //
 // Callback types.
 //
@@ -247,6 +309,18 @@ typedef enum cargo_validate_choices_flags_e
 typedef int (*cargo_custom_f)(cargo_t ctx, void *user, const char *optname,
                                 int argc, char **argv);
 
+// Returns the next argument for cargo_parse_stream, or NULL at the end.
+// The string only has to stay valid until the next call.
+typedef const char *(*cargo_next_arg_f)(void *user);
+
+// Adds the options of a subcommand to its own context, only
+// called when the subcommand is selected. Returns 0 on success.
+typedef int (*cargo_subcommand_f)(cargo_t ctx, void *user);
+
+// Returns the index of the option with the given name or alias,
+// or -1 if there is none. Generated by cargo_helper --spec.
+typedef int (*cargo_lookup_f)(const char *name);
+
 typedef void *(*cargo_malloc_f)(size_t bytes);
 typedef void (*cargo_free_f)(void *ptr);
 typedef void *(*cargo_realloc_f)(void *ptr, size_t bytes);
@@ -263,6 +337,25 @@ void cargo_set_flags(cargo_t ctx, cargo_flags_t flags);
 
 cargo_flags_t cargo_get_flags(cargo_t ctx);
 
+int cargo_set_arena(cargo_t ctx, size_t size_hint);
+
+void cargo_reset(cargo_t ctx);
+
+int cargo_spec_create(cargo_spec_t *spec, cargo_t *ctx);
+
+cargo_spec_t cargo_spec_ref(cargo_spec_t spec);
+
+void cargo_spec_release(cargo_spec_t *spec);
+
+int cargo_state_init(cargo_state_t *state, cargo_spec_t spec);
+
+int cargo_bind_target(cargo_t ctx, const char *opt,
+                      void *target, size_t *target_count);
+
+int cargo_spec_save(cargo_t ctx, void **buf, size_t *len);
+
+int cargo_spec_load(cargo_t ctx, const void *ptr, size_t len);
+
 int cargo_add_optionv(cargo_t ctx, cargo_option_flags_t flags,
                       const char *optnames,
                       const char *description,
@@ -272,6 +365,9 @@ int cargo_add_option(cargo_t ctx, cargo_option_flags_t flags,
                     const char *optnames, const char *description,
                     const char *fmt, ...);
 
+int cargo_add_options_table(cargo_t ctx,
+                            const cargo_option_decl_t *decls, size_t n);
+
 int cargo_add_alias(cargo_t ctx, const char *optname, const char *alias);
 
 int cargo_set_metavarv(cargo_t ctx,
@@ -282,6 +378,15 @@ int cargo_set_metavar(cargo_t ctx,
                     const char *optname,
                     const char *fmt, ...);
 
+int cargo_set_option_delimiter(cargo_t ctx,
+                               const char *optname,
+                               char delimiter);
+
+int cargo_set_option_enum(cargo_t ctx,
+                          const char *optname,
+                          cargo_validate_choices_flags_t flags,
+                          const cargo_enum_t *names, size_t count);
+
 int cargo_set_option_descriptionv(cargo_t ctx,
                                   const char *optname,
                                   const char *fmt, va_list ap);
@@ -318,15 +423,33 @@ int cargo_mutex_group_set_metavar(cargo_t ctx,
 
 void cargo_set_internal_usage_flags(cargo_t ctx, cargo_usage_t flags);
 
+int cargo_set_option_lookup(cargo_t ctx, cargo_lookup_f lookup);
+
+int cargo_set_usage_text(cargo_t ctx, const char *usage,
+                         const char *short_usage);
+
 cargo_parse_result_t cargo_parse(cargo_t ctx, cargo_flags_t flags,
                                 int start_index, int argc, char **argv);
 
+cargo_parse_result_t cargo_parse_stream(cargo_t ctx, cargo_flags_t flags,
+                                        cargo_next_arg_f next, void *user);
+
+void cargo_set_stream_lookahead(cargo_t ctx, size_t lookahead);
+
+cargo_parse_result_t cargo_parse_begin(cargo_t ctx, cargo_flags_t flags);
+
+cargo_parse_result_t cargo_parse_feed(cargo_t ctx, int argc, char **argv);
+
+cargo_parse_result_t cargo_parse_end(cargo_t ctx);
+
 void cargo_set_prefix(cargo_t ctx, const char *prefix_chars);
 
 void cargo_set_max_width(cargo_t ctx, size_t max_width);
 
 int cargo_get_width(cargo_t ctx, cargo_width_flags_t flags);
 
+void cargo_set_suggestion_distance(cargo_t ctx, size_t max_distance);
+
 void cargo_set_prognamev(cargo_t ctx, const char *fmt, va_list ap);
 
 void cargo_set_progname(cargo_t ctx, const char *fmt, ...);
@@ -363,6 +486,12 @@ char **cargo_get_args_copy(cargo_t ctx, size_t *argc);
 
 int cargo_get_stop_index(cargo_t ctx);
 
+int cargo_add_subcommand(cargo_t ctx, const char *name,
+                         const char *description,
+                         cargo_subcommand_f build, void *user);
+
+cargo_t cargo_get_subcommand(cargo_t ctx, const char **name);
+
 void cargo_set_context(cargo_t ctx, void *user);
 
 void *cargo_get_context(cargo_t ctx);
@@ -401,6 +530,12 @@ typedef int (*cargo_validation_f)(cargo_t ctx,
                                 const char *opt, cargo_validation_t *vd,
                                 void *value);
 
+typedef int (*cargo_validation_batch_f)(cargo_t ctx,
+                                cargo_validation_flags_t flags,
+                                const char *opt, cargo_validation_t *vd,
+                                const void *values, size_t count,
+                                size_t *bad_index);
+
 typedef void (*cargo_validation_destroy_f)(void *user);
 
 #define CARGO_DEFAULT_EPSILON 0.000000000000000001
@@ -416,6 +551,9 @@ cargo_validation_t *cargo_create_validator(const char *name,
 
 void *cargo_validator_get_context(cargo_validation_t *validator);
 
+int cargo_validator_set_batch(cargo_validation_t *validator,
+                              cargo_validation_batch_f batch);
+
 //
 // Validators.
 //
@@ -455,7 +593,8 @@ typedef enum cargo_fprint_flags_e
 
 typedef enum cargo_splitcmd_flags_e
 {
-    CARGO_SPLITCMD_DEFAULT = 0
+    CARGO_SPLITCMD_DEFAULT = 0,
+    CARGO_SPLITCMD_SYSTEM = (1 << 0)
 } cargo_splitcmd_flags_t;
 
 //
@@ -495,4 +634,60 @@ char **cargo_split_commandline(cargo_splitcmd_flags_t flags,
 
 void cargo_free_commandline(char ***argv, int argc);
 
+//
+// Batch parsing.
+//
+
+typedef struct cargo_batch_result_s
+{
+    int result;                     // Returned by cargo_parse.
+    int argc;                       // Number of arguments in the line.
+    char *error;                    // Error message, or NULL.
+} cargo_batch_result_t;
+
+typedef struct cargo_batch_stats_s
+{
+    size_t count;                   // Lines parsed.
+    size_t ok;                      // CARGO_PARSE_OK.
+    size_t help;                    // CARGO_PARSE_SHOW_HELP.
+    size_t failed;                  // Any error.
+    size_t first_failed;            // Index of the first failed line.
+    size_t args;                    // Total number of arguments.
+    size_t max_args;                // Most arguments in a single line.
+    size_t threads;                 // Workers used.
+} cargo_batch_stats_t;
+
+// Called once in each worker with its own state, before parsing.
+typedef int (*cargo_batch_init_f)(cargo_t state, size_t worker, void *user);
+
+// Called in the worker after each line is parsed.
+typedef int (*cargo_batch_entry_f)(cargo_t state, size_t worker, size_t index,
+                                   const cargo_batch_result_t *result,
+                                   void *user);
+
+typedef struct cargo_batch_s
+{
+    size_t threads;                 // Number of workers, 0 means 1.
+                                    // Only 1 without init or with
+                                    // CARGO_SPLITCMD_SYSTEM.
+    cargo_flags_t flags;            // Passed to cargo_parse.
+    int start;                      // Passed to cargo_parse.
+    cargo_splitcmd_flags_t split_flags;
+    cargo_batch_init_f init;        // Can be NULL.
+    cargo_batch_entry_f entry;      // Can be NULL.
+    void *user;
+} cargo_batch_t;
+
+int cargo_batch_parse(cargo_spec_t spec, const cargo_batch_t *batch,
+                      const char **lines, size_t count,
+                      cargo_batch_result_t **results,
+                      cargo_batch_stats_t *stats);
+
+int cargo_batch_parse_buffer(cargo_spec_t spec, const cargo_batch_t *batch,
+                             const char *buf, size_t len,
+                             cargo_batch_result_t **results, size_t *count,
+                             cargo_batch_stats_t *stats);
+
+void cargo_batch_free_results(cargo_batch_result_t **results, size_t count);
+
 #endif // __CARGO_H__